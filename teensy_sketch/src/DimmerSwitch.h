@@ -41,6 +41,15 @@ typedef void (*on_switch_func)(struct _DimmerSwitch *self, bool is_on, void *use
  */
 typedef void (*on_dim_func)(struct _DimmerSwitch *self, uint8_t dim_value, void *user_data);
 
+/**
+ * Callback function when the switch dimmer value changes, at full resolution.
+ * @param  self         The object to apply the function to.
+ * @param  dim_value	0 - 65535 magnitude where 0 is fully dimmed and 65535 is
+ *                      not dimmed.
+ * @param  user_data    Pointer provided to the callback registration.
+ */
+typedef void (*on_dim16_func)(struct _DimmerSwitch *self, uint16_t dim_value, void *user_data);
+
 typedef struct _DimmerSwitch {
     /**
      * Call this method continuously to give CPU time to the dimmer switch driver.
@@ -49,6 +58,7 @@ typedef struct _DimmerSwitch {
 
     void (*set_on_switch)(struct _DimmerSwitch *self, on_switch_func callback, void *user_data);
     void (*set_on_dim)(struct _DimmerSwitch *self, on_dim_func callback, void *user_data);
+    void (*set_on_dim16)(struct _DimmerSwitch *self, on_dim16_func callback, void *user_data);
 
     /**
      * Provide the dimmer with an indicator LED pin (GPIO) used to show when it
@@ -0,0 +1,60 @@
+/**
+ * Copyright 2016 Scott Dixon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Maximum number of pixels a single frame can carry. Each pixel costs 12 bytes
+ * of RAM per waveform buffer and there are two buffers.
+ */
+#ifndef PIXEL_OUTPUT_MAX_PIXELS
+#define PIXEL_OUTPUT_MAX_PIXELS (16)
+#endif
+
+typedef struct _PixelOutput {
+    /**
+     * Encode a frame and queue it for output. This returns as soon as the frame
+     * is encoded; the previous frame, if still being sent, is not disturbed.
+     * Calling show again before a queued frame has started replaces it.
+     * @param  self         The object to apply the function to.
+     * @param  rgb_pixels   pixel_count R,G,B triplets (the CRGB memory layout).
+     * @param  pixel_count  Number of pixels in rgb_pixels.
+     * @return false if pixel_count exceeds PIXEL_OUTPUT_MAX_PIXELS (nothing is
+     *         queued) else true.
+     */
+    bool (*show)(struct _PixelOutput *self, const uint8_t *rgb_pixels, size_t pixel_count);
+
+    /**
+     * True while a frame (including its latch time) is being sent.
+     */
+    bool (*is_busy)(struct _PixelOutput *self);
+} PixelOutput;
+
+/**
+ * Get the singleton WS2812 output. Frames are sent on pin 11 (SPI0 MOSI) by
+ * DMA so interrupts stay enabled while the strip is refreshed.
+ */
+PixelOutput *get_instance_ws2812_dma();
+
+#ifdef __cplusplus
+}
+#endif
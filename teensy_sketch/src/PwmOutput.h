@@ -0,0 +1,44 @@
+/**
+ * Copyright 2016 Scott Dixon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct _PwmOutput {
+    /**
+     * Set the output level. The level is perceptual (CIE lightness) and is
+     * mapped to a 16 bit duty cycle plus temporal dithering. The new duty
+     * cycle takes effect at the start of the next PWM period so this can be
+     * called at any rate without glitches.
+     * @param  self         The object to apply the function to.
+     * @param  level        0 - 65535 where 0 is off and 65535 is fully on.
+     */
+    void (*set_level)(struct _PwmOutput *self, uint16_t level);
+} PwmOutput;
+
+/**
+ * Get the singleton FlexTimer PWM output. The output is on pin 3 (FTM1_CH0)
+ * and is active high.
+ */
+PwmOutput *get_instance_ftm_pwm();
+
+#ifdef __cplusplus
+}
+#endif
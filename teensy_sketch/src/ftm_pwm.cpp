@@ -0,0 +1,157 @@
+/**
+ * Copyright 2016 Scott Dixon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <Arduino.h>
+#include <PwmOutput.h>
+
+// +---------------------------------------------------------------------------+
+// | PERCEPTUAL CURVE
+// +---------------------------------------------------------------------------+
+// MOD is one less than the 16 bit range so a C0V of 0xFFFF (> MOD) is 100% on.
+// The period is 65535 bus clocks (732Hz at F_BUS = 48MHz).
+#define FTM_PWM_MOD 0xFFFE
+
+/**
+ * CIE 1931 lightness to luminance, sampled at 257 points over the 16 bit level
+ * range. Values are 16.8 fixed point duty cycles; the fraction is dithered.
+ */
+static const uint32_t _lightness_to_duty[257] = {
+    0x000000, 0x001C57, 0x0038AE, 0x005505, 0x00715C, 0x008DB3,
+    0x00AA0A, 0x00C661, 0x00E2B9, 0x00FF10, 0x011B67, 0x0137BE,
+    0x015415, 0x01706C, 0x018CC3, 0x01A91A, 0x01C571, 0x01E1C8,
+    0x01FE1F, 0x021A76, 0x0236CD, 0x025345, 0x02708F, 0x028ECB,
+    0x02ADFD, 0x02CE29, 0x02EF52, 0x03117D, 0x0334AD, 0x0358E6,
+    0x037E2C, 0x03A482, 0x03CBED, 0x03F471, 0x041E11, 0x0448D1,
+    0x0474B5, 0x04A1C1, 0x04CFF9, 0x04FF60, 0x052FFA, 0x0561CC,
+    0x0594D9, 0x05C924, 0x05FEB3, 0x063588, 0x066DA7, 0x06A715,
+    0x06E1D4, 0x071DEA, 0x075B59, 0x079A26, 0x07DA55, 0x081BE9,
+    0x085EE6, 0x08A350, 0x08E92B, 0x09307B, 0x097943, 0x09C387,
+    0x0A0F4C, 0x0A5C95, 0x0AAB66, 0x0AFBC3, 0x0B4DAF, 0x0BA12E,
+    0x0BF645, 0x0C4CF7, 0x0CA549, 0x0CFF3C, 0x0D5AD7, 0x0DB81C,
+    0x0E1710, 0x0E77B5, 0x0EDA11, 0x0F3E27, 0x0FA3FA, 0x100B8F,
+    0x1074E9, 0x10E00D, 0x114CFE, 0x11BBBF, 0x122C56, 0x129EC5,
+    0x131311, 0x13893D, 0x14014D, 0x147B45, 0x14F729, 0x1574FD,
+    0x15F4C4, 0x167683, 0x16FA3C, 0x177FF5, 0x1807B1, 0x189174,
+    0x191D41, 0x19AB1D, 0x1A3B0B, 0x1ACD0F, 0x1B612E, 0x1BF76A,
+    0x1C8FC7, 0x1D2A4B, 0x1DC6F7, 0x1E65D1, 0x1F06DC, 0x1FAA1C,
+    0x204F94, 0x20F749, 0x21A13F, 0x224D79, 0x22FBFB, 0x23ACC8,
+    0x245FE6, 0x251558, 0x25CD20, 0x268745, 0x2743C8, 0x2802AE,
+    0x28C3FB, 0x2987B3, 0x2A4DDA, 0x2B1673, 0x2BE182, 0x2CAF0B,
+    0x2D7F12, 0x2E519B, 0x2F26AA, 0x2FFE42, 0x30D867, 0x31B51E,
+    0x329469, 0x33764D, 0x345ACE, 0x3541F0, 0x362BB6, 0x371824,
+    0x38073E, 0x38F908, 0x39ED86, 0x3AE4BB, 0x3BDEAC, 0x3CDB5C,
+    0x3DDAD0, 0x3EDD0A, 0x3FE20F, 0x40E9E3, 0x41F489, 0x430205,
+    0x44125C, 0x452591, 0x463BA7, 0x4754A4, 0x487089, 0x498F5D,
+    0x4AB121, 0x4BD5DB, 0x4CFD8D, 0x4E283D, 0x4F55ED, 0x5086A1,
+    0x51BA5E, 0x52F127, 0x542B00, 0x5567EC, 0x56A7F1, 0x57EB11,
+    0x593150, 0x5A7AB3, 0x5BC73C, 0x5D16F1, 0x5E69D4, 0x5FBFEA,
+    0x611936, 0x6275BD, 0x63D581, 0x653888, 0x669ED4, 0x68086B,
+    0x69754E, 0x6AE583, 0x6C590D, 0x6DCFF1, 0x6F4A31, 0x70C7D2,
+    0x7248D7, 0x73CD45, 0x75551F, 0x76E069, 0x786F27, 0x7A015D,
+    0x7B970E, 0x7D303F, 0x7ECCF3, 0x806D2F, 0x8210F5, 0x83B84B,
+    0x856333, 0x8711B1, 0x88C3CA, 0x8A7981, 0x8C32DA, 0x8DEFD9,
+    0x8FB082, 0x9174D9, 0x933CE1, 0x95089E, 0x96D814, 0x98AB47,
+    0x9A823B, 0x9C5CF4, 0x9E3B75, 0xA01DC3, 0xA203E1, 0xA3EDD3,
+    0xA5DB9C, 0xA7CD42, 0xA9C2C7, 0xABBC2F, 0xADB97F, 0xAFBABA,
+    0xB1BFE4, 0xB3C900, 0xB5D613, 0xB7E721, 0xB9FC2D, 0xBC153B,
+    0xBE324F, 0xC0536D, 0xC27899, 0xC4A1D6, 0xC6CF28, 0xC90094,
+    0xCB361D, 0xCD6FC7, 0xCFAD96, 0xD1EF8D, 0xD435B0, 0xD68004,
+    0xD8CE8C, 0xDB214C, 0xDD7848, 0xDFD384, 0xE23303, 0xE496C9,
+    0xE6FEDB, 0xE96B3B, 0xEBDBEF, 0xEE50F9, 0xF0CA5E, 0xF34821,
+    0xF5CA47, 0xF850D2, 0xFADBC8, 0xFD6B2B, 0xFFFF00
+};
+
+/**
+ * Map a level to a 16.8 duty cycle by linear interpolation between curve points.
+ * The last point sits at 65536 so the top level is pinned to fully on.
+ */
+static uint32_t _level_to_duty(uint16_t level)
+{
+    if (level == 0xFFFF) {
+        return _lightness_to_duty[256];
+    }
+    const uint32_t a    = _lightness_to_duty[level >> 8];
+    const uint32_t b    = _lightness_to_duty[(level >> 8) + 1];
+    const uint32_t frac = level & 0xFF;
+    return a + (((b - a) * frac) >> 8);
+}
+
+// +---------------------------------------------------------------------------+
+// | PwmOutput :: PRIVATE DATA
+// +---------------------------------------------------------------------------+
+typedef struct _FtmPwmOutput {
+    PwmOutput super;
+    // 16.8 fixed point duty cycle the overflow ISR dithers onto C0V.
+    volatile uint32_t duty;
+    uint32_t dither_error;
+} FtmPwmOutput;
+
+static FtmPwmOutput _singleton;
+static PwmOutput *_singleton_ptr = 0;
+
+// +---------------------------------------------------------------------------+
+// | PwmOutput :: PRIVATE METHODS
+// +---------------------------------------------------------------------------+
+/**
+ * Runs once per PWM period. C0V is double buffered by the FTM and loads at the
+ * next overflow, so the duty cycle never changes mid-period. The 8 fractional
+ * duty bits are spread over successive periods by a first order sigma-delta.
+ */
+void ftm1_isr(void)
+{
+    FtmPwmOutput *ftmself = &_singleton;
+    FTM1_SC &= ~FTM_SC_TOF;
+
+    const uint32_t duty  = ftmself->duty;
+    const uint32_t error = ftmself->dither_error + (duty & 0xFF);
+    FTM1_C0V              = (duty >> 8) + (error >> 8);
+    ftmself->dither_error = error & 0xFF;
+}
+
+// +---------------------------------------------------------------------------+
+// | PwmOutput :: PUBLIC
+// +---------------------------------------------------------------------------+
+static void _set_level(PwmOutput *self, uint16_t level)
+{
+    ((FtmPwmOutput *)self)->duty = _level_to_duty(level);
+}
+
+static FtmPwmOutput *init_ftmpwmoutput(FtmPwmOutput *self)
+{
+    if (self) {
+        memset(self, 0, sizeof(FtmPwmOutput));
+        self->super.set_level = _set_level;
+
+        FTM1_SC          = 0;
+        FTM1_CNT         = 0;
+        FTM1_MOD         = FTM_PWM_MOD;
+        FTM1_C0SC        = FTM_CSC_MSB | FTM_CSC_ELSB;
+        FTM1_C0V         = 0;
+        CORE_PIN3_CONFIG = PORT_PCR_MUX(3) | PORT_PCR_DSE | PORT_PCR_SRE;
+        FTM1_SC          = FTM_SC_CLKS(1) | FTM_SC_PS(0) | FTM_SC_TOIE;
+        NVIC_ENABLE_IRQ(IRQ_FTM1);
+    }
+    return self;
+}
+
+PwmOutput *get_instance_ftm_pwm()
+{
+    noInterrupts();
+    if (!_singleton_ptr) {
+        _singleton_ptr = &init_ftmpwmoutput(&_singleton)->super;
+    }
+    interrupts();
+    return _singleton_ptr;
+}
@@ -15,6 +15,8 @@
  */
 #include <Arduino.h>
 #include <DimmerSwitch.h>
+#include <PixelOutput.h>
+#include <PwmOutput.h>
 #include "FastLED.h"
 
 // +---------------------------------------------------------------------------+
@@ -24,10 +26,20 @@
 #define UNUSED(STATEMENT) (void) STATEMENT
 #endif
 
-#define WS2812_DATA (11)
 #define TEENSY_LED (13)
 #define DIMVALUE_AVERAGE_SIZE (64)
 
+#define LIGHT_OUTPUT_WS2812 (0)
+#define LIGHT_OUTPUT_PWM (1)
+
+/**
+ * Select the light to drive: the WS2812 on the dev board (pin 11) or a 16 bit
+ * FlexTimer PWM output (pin 3) for loads that are not addressable LEDs.
+ */
+#ifndef LIGHT_OUTPUT
+#define LIGHT_OUTPUT LIGHT_OUTPUT_WS2812
+#endif
+
 // +---------------------------------------------------------------------------+
 // | STATIC DATA
 // +---------------------------------------------------------------------------+
@@ -39,8 +51,15 @@ static const CRGB _on_colour(CRGB::White);
 static const size_t leds_count = 1;
 static CRGB leds[leds_count];
 static DimmerSwitch *_light_switch;
+#if LIGHT_OUTPUT == LIGHT_OUTPUT_PWM
+static PwmOutput *_pwm;
+#else
+// WS2812 strip on pin 11 (SPI0 MOSI).
+static PixelOutput *_pixels;
+#endif
 static CRGB _colour(_on_colour);
-static uint32_t _target_brightness = 255;
+static bool _is_on                 = true;
+static uint32_t _target_brightness = 65535;
 
 // +---------------------------------------------------------------------------+
 // | DimmerSwitch CALLBACKS
@@ -49,6 +68,7 @@ static void _on_switch(DimmerSwitch *lightswitch, bool is_on, void *user_data)
 {
     UNUSED(lightswitch);
     UNUSED(user_data);
+    _is_on = is_on;
     if (!is_on) {
         _colour = CRGB::Black;
     } else {
@@ -56,7 +76,7 @@ static void _on_switch(DimmerSwitch *lightswitch, bool is_on, void *user_data)
     }
 }
 
-static void _on_dim(DimmerSwitch *lightswitch, uint8_t dim_value, void *user_data)
+static void _on_dim(DimmerSwitch *lightswitch, uint16_t dim_value, void *user_data)
 {
     const uint32_t current_brightness = _target_brightness;
     _target_brightness *= DIMVALUE_AVERAGE_SIZE;
@@ -70,11 +90,15 @@ static void _on_dim(DimmerSwitch *lightswitch, uint8_t dim_value, void *user_dat
 // +---------------------------------------------------------------------------+
 void setup()
 {
-    FastLED.addLeds<WS2812B, WS2812_DATA, GRB>(leds, leds_count);
+#if LIGHT_OUTPUT == LIGHT_OUTPUT_PWM
+    _pwm = get_instance_ftm_pwm();
+#else
+    _pixels = get_instance_ws2812_dma();
+#endif
     _light_switch = get_instance_switch();
     _light_switch->set_indicator_pin(_light_switch, TEENSY_LED, true);
     _light_switch->set_on_switch(_light_switch, _on_switch, 0);
-    _light_switch->set_on_dim(_light_switch, _on_dim, 0);
+    _light_switch->set_on_dim16(_light_switch, _on_dim, 0);
     Serial.begin(115200);
     pinMode(LED_BUILTIN, OUTPUT);
     Serial.println("Starting dimmer sample...");
@@ -83,6 +107,13 @@ void setup()
 void loop()
 {
     _light_switch->service(_light_switch);
-    FastLED.setBrightness(_target_brightness);
-    FastLED.showColor(_colour);
+#if LIGHT_OUTPUT == LIGHT_OUTPUT_PWM
+    _pwm->set_level(_pwm, (_is_on) ? _target_brightness : 0);
+#else
+    for (size_t i = 0; i < leds_count; ++i) {
+        leds[i] = _colour;
+        leds[i].nscale8_video(_target_brightness >> 8);
+    }
+    _pixels->show(_pixels, (const uint8_t *)leds, leds_count);
+#endif
 }
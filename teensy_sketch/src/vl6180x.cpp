@@ -293,6 +293,8 @@ typedef struct _Vl6180Switch {
     void *on_click_user_data;
     on_dim_func on_down_callback;
     void *on_down_user_data;
+    on_dim16_func on_down16_callback;
+    void *on_down16_user_data;
     Vl6180State state;
     uint32_t range_count;
     uint32_t powered_on_at_millis;
@@ -320,12 +322,17 @@ static void _notify_down(Vl6180Switch *vlself, uint8_t distance_mm)
     noInterrupts();
     on_dim_func on_down = vlself->on_down_callback;
     void *user_data = vlself->on_down_user_data;
+    on_dim16_func on_down16 = vlself->on_down16_callback;
+    void *user_data16       = vlself->on_down16_user_data;
     interrupts();
 
+    const uint16_t dim_value =
+        map(constrain(distance_mm, 10, NEAR_THRESHOLD_MM), 10, NEAR_THRESHOLD_MM, 0, 65535);
     if (on_down) {
-        on_down(&vlself->super,
-                map(constrain(distance_mm, 10, NEAR_THRESHOLD_MM), 10, NEAR_THRESHOLD_MM, 0, 255),
-                user_data);
+        on_down(&vlself->super, dim_value >> 8, user_data);
+    }
+    if (on_down16) {
+        on_down16(&vlself->super, dim_value, user_data16);
     }
 }
 
@@ -485,6 +492,15 @@ static void _set_on_down(DimmerSwitch *self, on_dim_func callback, void *user_da
     interrupts();
 }
 
+static void _set_on_down16(DimmerSwitch *self, on_dim16_func callback, void *user_data)
+{
+    Vl6180Switch *vlself = (Vl6180Switch *)self;
+    noInterrupts();
+    vlself->on_down16_callback  = callback;
+    vlself->on_down16_user_data = user_data;
+    interrupts();
+}
+
 static void _set_indicator_pin(DimmerSwitch *self, unsigned int pin, bool active_high)
 {
     Vl6180Switch *vlself          = (Vl6180Switch *)self;
@@ -506,6 +522,7 @@ static Vl6180Switch *init_vl6180switch(Vl6180Switch *self)
         memset(self, 0, sizeof(Vl6180Switch));
         self->super.set_on_switch     = _set_on_switch;
         self->super.set_on_dim        = _set_on_down;
+        self->super.set_on_dim16      = _set_on_down16;
         self->super.set_indicator_pin = _set_indicator_pin;
         self->super.service           = _service;
         self->state                   = Vl6180STATE_NOT_INIT;
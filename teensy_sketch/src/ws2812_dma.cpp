@@ -0,0 +1,193 @@
+/**
+ * Copyright 2016 Scott Dixon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <Arduino.h>
+#include <DMAChannel.h>
+#include <PixelOutput.h>
+
+// +---------------------------------------------------------------------------+
+// | WS2812 WAVEFORM
+// +---------------------------------------------------------------------------+
+// Each WS2812 bit is sent as three SPI bits at 2.4MHz (417ns per slot):
+//
+//      0 -> 100 : 417ns high, 833ns low
+//      1 -> 110 : 833ns high, 417ns low
+//
+// SPI frames are 12 bits so every frame carries one nibble and always ends on a
+// low slot. Any gap the DSPI inserts between frames therefore only stretches
+// a low period, which the WS2812 tolerates.
+
+#define WS2812_SPI_HZ 2400000
+#define WS2812_FRAMES_PER_PIXEL 6
+// WS2812B needs >= 280us of low to latch. Each 12 bit frame is 5us.
+#define WS2812_LATCH_FRAMES 60
+#define WS2812_BUFFER_FRAMES                                                                       \
+    (PIXEL_OUTPUT_MAX_PIXELS * WS2812_FRAMES_PER_PIXEL + WS2812_LATCH_FRAMES)
+
+#if F_BUS == 48000000
+#define WS2812_SPI_CTAR_CLOCK (SPI_CTAR_PBR(2) | SPI_CTAR_BR(1))
+#elif F_BUS == 36000000
+#define WS2812_SPI_CTAR_CLOCK (SPI_CTAR_PBR(2) | SPI_CTAR_BR(2) | SPI_CTAR_DBR)
+#elif F_BUS == 24000000
+#define WS2812_SPI_CTAR_CLOCK (SPI_CTAR_PBR(2) | SPI_CTAR_BR(0))
+#else
+#error "No SPI divider for WS2812_SPI_HZ at this F_BUS. Use a 96, 72, or 48MHz CPU clock."
+#endif
+
+/**
+ * 12 bit SPI frame for each nibble: 0x924 sets the leading "1" slot of all four
+ * bits and the nibble's bits land in the middle slots.
+ */
+static const uint16_t _nibble_frames[16] = {0x924, 0x926, 0x934, 0x936, 0x9A4, 0x9A6,
+                                            0x9B4, 0x9B6, 0xD24, 0xD26, 0xD34, 0xD36,
+                                            0xDA4, 0xDA6, 0xDB4, 0xDB6};
+
+static inline uint16_t *_encode_byte(uint16_t *out, uint8_t value)
+{
+    *out++ = _nibble_frames[value >> 4];
+    *out++ = _nibble_frames[value & 0xF];
+    return out;
+}
+
+/**
+ * Encode RGB pixels into WS2812 (GRB) frames followed by the latch period.
+ * @return the number of frames written.
+ */
+static size_t _encode_frames(uint16_t *out, const uint8_t *rgb_pixels, size_t pixel_count)
+{
+    uint16_t *const start = out;
+    for (size_t i = 0; i < pixel_count; ++i, rgb_pixels += 3) {
+        out = _encode_byte(out, rgb_pixels[1]);
+        out = _encode_byte(out, rgb_pixels[0]);
+        out = _encode_byte(out, rgb_pixels[2]);
+    }
+    memset(out, 0, WS2812_LATCH_FRAMES * sizeof(uint16_t));
+    out += WS2812_LATCH_FRAMES;
+    return out - start;
+}
+
+// +---------------------------------------------------------------------------+
+// | PixelOutput :: PRIVATE DATA
+// +---------------------------------------------------------------------------+
+typedef struct _Ws2812DmaOutput {
+    PixelOutput super;
+    DMAChannel *dma;
+    uint16_t buffers[2][WS2812_BUFFER_FRAMES];
+    size_t buffer_frames[2];
+    // Index of the buffer show() encodes into. The other one belongs to the DMA.
+    volatile uint8_t back;
+    volatile bool is_busy;
+    volatile bool is_pending;
+} Ws2812DmaOutput;
+
+static Ws2812DmaOutput _singleton;
+static PixelOutput *_singleton_ptr = 0;
+static DMAChannel _dma;
+
+// +---------------------------------------------------------------------------+
+// | PixelOutput :: PRIVATE METHODS
+// +---------------------------------------------------------------------------+
+/**
+ * Hand the back buffer to the DMA. Call with interrupts disabled.
+ */
+static void _start_back_buffer(Ws2812DmaOutput *wsself)
+{
+    const uint8_t back = wsself->back;
+    wsself->dma->sourceBuffer(wsself->buffers[back],
+                              wsself->buffer_frames[back] * sizeof(uint16_t));
+    wsself->back    = back ^ 1;
+    wsself->is_busy = true;
+    wsself->dma->enable();
+}
+
+static void _on_dma_complete()
+{
+    Ws2812DmaOutput *wsself = &_singleton;
+    wsself->dma->clearInterrupt();
+    if (wsself->is_pending) {
+        wsself->is_pending = false;
+        _start_back_buffer(wsself);
+    } else {
+        wsself->is_busy = false;
+    }
+}
+
+// +---------------------------------------------------------------------------+
+// | PixelOutput :: PUBLIC
+// +---------------------------------------------------------------------------+
+static bool _show(PixelOutput *self, const uint8_t *rgb_pixels, size_t pixel_count)
+{
+    Ws2812DmaOutput *wsself = (Ws2812DmaOutput *)self;
+    if (pixel_count > PIXEL_OUTPUT_MAX_PIXELS) {
+        return false;
+    }
+
+    // Withdraw any queued frame so the DMA can't pick up the back buffer while
+    // it is being rewritten.
+    noInterrupts();
+    wsself->is_pending = false;
+    interrupts();
+
+    const uint8_t back          = wsself->back;
+    wsself->buffer_frames[back] = _encode_frames(wsself->buffers[back], rgb_pixels, pixel_count);
+
+    noInterrupts();
+    if (wsself->is_busy) {
+        wsself->is_pending = true;
+    } else {
+        _start_back_buffer(wsself);
+    }
+    interrupts();
+    return true;
+}
+
+static bool _is_busy(PixelOutput *self)
+{
+    return ((Ws2812DmaOutput *)self)->is_busy;
+}
+
+static Ws2812DmaOutput *init_ws2812dmaoutput(Ws2812DmaOutput *self)
+{
+    if (self) {
+        memset(self, 0, sizeof(Ws2812DmaOutput));
+        self->super.show    = _show;
+        self->super.is_busy = _is_busy;
+        self->dma           = &_dma;
+
+        SIM_SCGC6 |= SIM_SCGC6_SPI0;
+        SPI0_MCR          = SPI_MCR_MSTR | SPI_MCR_HALT | SPI_MCR_DIS_RXF;
+        SPI0_CTAR0        = SPI_CTAR_FMSZ(11) | WS2812_SPI_CTAR_CLOCK;
+        SPI0_RSER         = SPI_RSER_TFFF_RE | SPI_RSER_TFFF_DIRS;
+        SPI0_MCR          = SPI_MCR_MSTR | SPI_MCR_DIS_RXF | SPI_MCR_CLR_TXF | SPI_MCR_CLR_RXF;
+        CORE_PIN11_CONFIG = PORT_PCR_DSE | PORT_PCR_MUX(2);
+
+        self->dma->destination((volatile uint16_t &)SPI0_PUSHR);
+        self->dma->triggerAtHardwareEvent(DMAMUX_SOURCE_SPI0_TX);
+        self->dma->disableOnCompletion();
+        self->dma->interruptAtCompletion();
+        self->dma->attachInterrupt(_on_dma_complete);
+    }
+    return self;
+}
+
+PixelOutput *get_instance_ws2812_dma()
+{
+    noInterrupts();
+    if (!_singleton_ptr) {
+        _singleton_ptr = &init_ws2812dmaoutput(&_singleton)->super;
+    }
+    interrupts();
+    return _singleton_ptr;
+}